@@ -0,0 +1,281 @@
+#ifndef ASYNC_QUERY_H
+#define ASYNC_QUERY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+Asynchronous query execution.
+
+Long operations (big query results, full-view prints) run on a ThreadPool as
+StreamingTasks. A task:
+  - hands its output back in batches through a bounded queue (the producer
+    waits when the consumer falls behind, so memory stays flat);
+  - reports progress (done / total);
+  - can be cancelled, and can have a deadline; the producer checks both
+    between batches via TaskContext::shouldStop().
+
+The caller's thread never blocks for longer than the timeout it passes to
+next(), so an interactive loop (or a future server) stays responsive.
+Built on std::thread / std::future (C++17), no coroutines needed.
+*/
+
+// Fixed-size worker pool. Tasks are run in submission order.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency())) {
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Run f() on a worker; the future reports completion (or f's exception).
+    std::future<void> submit(std::function<void()> f) {
+        auto job = std::make_shared<std::packaged_task<void()>>(std::move(f));
+        std::future<void> done = job->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back([job]() { (*job)(); });
+        }
+        cv_.notify_one();
+        return done;
+    }
+
+private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty()) return; // stopping and nothing left
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+enum class TaskStatus {
+    Running,
+    Completed,
+    Cancelled,
+    DeadlineExceeded,
+    Failed       // the task threw; see StreamingTask::rethrowIfFailed()
+};
+
+struct TaskOptions {
+    std::chrono::milliseconds deadline{0}; // 0 = no deadline
+    std::size_t maxQueuedBatches = 16;     // back-pressure limit
+};
+
+template<typename Batch> class TaskContext;
+
+// Shared state between the producer (worker) and the consumer (caller).
+template<typename Batch>
+class StreamingTask {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StreamingTask(const TaskOptions& opts)
+        : capacity_(std::max<std::size_t>(1, opts.maxQueuedBatches)),
+          hasDeadline_(opts.deadline.count() > 0),
+          deadline_(Clock::now() + opts.deadline) {}
+
+    // Consumer side
+
+    // Wait up to `timeout` for the next batch. Returns false if none arrived
+    // (check finished() to tell "not yet" from "no more").
+    template<typename Rep, typename Period>
+    bool next(Batch& out, std::chrono::duration<Rep, Period> timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, timeout, [this]() { return !queue_.empty() || done_; });
+        if (queue_.empty()) return false;
+        out = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        cv_.notify_all(); // room for the producer
+        return true;
+    }
+
+    // True once the producer has stopped and every batch has been taken.
+    bool finished() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return done_ && queue_.empty();
+    }
+
+    void cancel() {
+        cancelRequested_ = true;
+        cv_.notify_all();
+    }
+
+    bool deadlinePassed() const {
+        return hasDeadline_ && Clock::now() >= deadline_;
+    }
+
+    TaskStatus status() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return status_;
+    }
+
+    std::size_t done() const { return done_items_; }
+    std::size_t total() const { return total_items_; }
+
+    // Block until the producer returns. Batches still queued, and any the
+    // producer emits meanwhile, are discarded (it never blocks on a full queue).
+    TaskStatus wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!done_) {
+            queue_.clear();
+            cv_.notify_all();
+            cv_.wait(lock);
+        }
+        queue_.clear();
+        return status_;
+    }
+
+    void rethrowIfFailed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    friend class TaskContext<Batch>;
+
+    bool stopRequested() const {
+        return cancelRequested_ || deadlinePassed();
+    }
+
+    // Producer side (through TaskContext)
+
+    bool push(Batch batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (queue_.size() >= capacity_) {
+            if (stopRequested()) return false;
+            cv_.wait_for(lock, std::chrono::milliseconds(20));
+        }
+        if (stopRequested()) return false;
+        queue_.push_back(std::move(batch));
+        lock.unlock();
+        cv_.notify_all();
+        return true;
+    }
+
+    void finish(bool stoppedEarly, std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error) {
+                status_ = TaskStatus::Failed;
+                error_  = error;
+            } else if (stoppedEarly) {
+                status_ = cancelRequested_ ? TaskStatus::Cancelled
+                                           : TaskStatus::DeadlineExceeded;
+            } else {
+                status_ = TaskStatus::Completed;
+            }
+            done_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Batch> queue_;
+    const std::size_t capacity_;
+    bool done_ = false;
+    TaskStatus status_ = TaskStatus::Running;
+    std::exception_ptr error_;
+
+    std::atomic<bool> cancelRequested_{false};
+    const bool hasDeadline_;
+    const Clock::time_point deadline_;
+
+    std::atomic<std::size_t> done_items_{0};
+    std::atomic<std::size_t> total_items_{0};
+};
+
+// What the producer function sees.
+template<typename Batch>
+class TaskContext {
+public:
+    explicit TaskContext(StreamingTask<Batch>& task) : task_(task) {}
+
+    // Check between units of work; once true, return as soon as possible.
+    bool shouldStop() {
+        if (task_.stopRequested()) stopped_ = true;
+        return stopped_;
+    }
+
+    // Hand a batch to the consumer. Returns false (batch dropped) if the task
+    // was cancelled or ran out of time while waiting for queue space.
+    bool emit(Batch batch) {
+        if (!task_.push(std::move(batch))) {
+            stopped_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void setTotal(std::size_t n) { task_.total_items_ = n; }
+    void advance(std::size_t n)  { task_.done_items_ += n; }
+
+    bool stopped() const { return stopped_; }
+
+    // Called once by runStreaming when the producer returns or throws.
+    void finish(std::exception_ptr error) { task_.finish(stopped_, error); }
+
+private:
+    StreamingTask<Batch>& task_;
+    bool stopped_ = false;
+};
+
+// Start work(ctx) on the pool; returns the handle to consume its batches.
+template<typename Batch, typename Work>
+std::shared_ptr<StreamingTask<Batch>> runStreaming(ThreadPool& pool, Work work,
+                                                   const TaskOptions& opts = TaskOptions{})
+{
+    auto task = std::make_shared<StreamingTask<Batch>>(opts);
+    pool.submit([task, work = std::move(work)]() mutable {
+        TaskContext<Batch> ctx(*task);
+        try {
+            work(ctx);
+            ctx.finish(nullptr);
+        } catch (...) {
+            ctx.finish(std::current_exception());
+        }
+    });
+    return task;
+}
+
+#endif // ASYNC_QUERY_H
@@ -0,0 +1,167 @@
+// bench_variant.cpp
+// Compares the polymorphic IStudentPtr path with the variant-based StudentStore
+// (variant_store.h) on the same CSV files: loading, sorted views, course index
+// and printing. Also checks that both paths produce identical output.
+//
+// Usage: ./bench_variant [repetitions] [file.csv ...]
+//        (defaults: 20 repetitions, the bundled CSV files)
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "csv_loader.h"
+#include "print_utils.h"
+#include "sorting.h"
+#include "course_index.h"
+#include "variant_store.h"
+
+namespace {
+
+// Stream that discards everything (printing cost without terminal I/O).
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Silences the [TIMER] lines buildAndSortViews writes to std::cout.
+class CoutSilencer {
+public:
+    CoutSilencer() : old_(std::cout.rdbuf(&sink_)) {}
+    ~CoutSilencer() { std::cout.rdbuf(old_); }
+private:
+    NullBuffer sink_;
+    std::streambuf* old_;
+};
+
+struct Timing {
+    std::vector<double> ms;
+
+    double min() const { return *std::min_element(ms.begin(), ms.end()); }
+    double median() const {
+        std::vector<double> v = ms;
+        std::sort(v.begin(), v.end());
+        return v[v.size() / 2];
+    }
+};
+
+template<typename F>
+Timing timeIt(int reps, F&& f) {
+    Timing t;
+    for (int i = 0; i < reps; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        t.ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return t;
+}
+
+void report(const std::string& phase, const Timing& ptr, const Timing& var) {
+    std::cout << "  " << std::left << std::setw(14) << phase << std::right
+              << std::fixed << std::setprecision(3)
+              << std::setw(10) << ptr.median() << std::setw(10) << ptr.min()
+              << std::setw(10) << var.median() << std::setw(10) << var.min()
+              << std::setw(9) << std::setprecision(2)
+              << (var.median() > 0 ? ptr.median() / var.median() : 0.0) << "x\n";
+}
+
+// Both paths must print exactly the same thing.
+bool sameOutput(const std::vector<IStudentPtr>& students, const SortViews& pv,
+                const StudentStore& store, const SortViews& vv) {
+    std::ostringstream a, b;
+    printStudentsInsertionOrder(students, a);
+    printStudentsByIndex(students, pv.byName.begin(), pv.byName.end(), a);
+    printStudentsByIndex(students, pv.byRoll.begin(), pv.byRoll.end(), a);
+    printStudentsInsertionOrder(store, b);
+    printStudentsByIndex(store, vv.byName.begin(), vv.byName.end(), b);
+    printStudentsByIndex(store, vv.byRoll.begin(), vv.byRoll.end(), b);
+    return a.str() == b.str();
+}
+
+bool sameQueries(const CourseIndexDB& pi, const CourseIndexDB& vi,
+                 const std::vector<IStudentPtr>& students, const StudentStore& store) {
+    std::ostringstream a, b;
+    for (const char* course : {"OOPD", "ML", "DSA", "801", "615"}) {
+        for (int t = 0; t <= 10; ++t) {
+            for (IStudent* s : pi.queryAtLeast(course, t)) printStudent(*s, a);
+            for (IStudent* s : vi.queryAtLeast(course, t)) printStudent(*s, b);
+        }
+    }
+    return !students.empty() && store.size() == students.size() && a.str() == b.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int reps = 20;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i == 1 && arg.find_first_not_of("0123456789") == std::string::npos) {
+            reps = std::max(1, std::stoi(arg));
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        files = {"students_iiit_3000.csv", "students_mixed.csv"};
+    }
+
+    for (const auto& file : files) {
+        std::vector<IStudentPtr> students;
+        StudentStore store;
+        try {
+            students = loadStudentsFromCSV(file);
+            store = loadStudentStoreFromCSV(file);
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading CSV: " << e.what() << "\n";
+            return 1;
+        }
+
+        std::cout << "\n=== " << file << " (" << students.size() << " students, "
+                  << reps << " reps) ===\n"
+                  << "  phase            IStudentPtr (ms)      variant (ms)   speedup\n"
+                  << "                   median     min    median     min\n";
+
+        Timing loadP = timeIt(reps, [&] { students = loadStudentsFromCSV(file); });
+        Timing loadV = timeIt(reps, [&] { store = loadStudentStoreFromCSV(file); });
+        report("load", loadP, loadV);
+
+        SortViews pv, vv;
+        Timing sortP, sortV;
+        {
+            CoutSilencer quiet;
+            sortP = timeIt(reps, [&] { pv = buildAndSortViews(students); });
+            sortV = timeIt(reps, [&] { vv = buildAndSortViews(store); });
+        }
+        report("sort views", sortP, sortV);
+
+        CourseIndexDB pi, vi;
+        Timing idxP = timeIt(reps, [&] { pi.build(students); });
+        Timing idxV = timeIt(reps, [&] { buildCourseIndex(vi, store); });
+        report("course index", idxP, idxV);
+
+        NullBuffer nullBuf;
+        std::ostream null(&nullBuf);
+        Timing prtP = timeIt(reps, [&] {
+            printStudentsByIndex(students, pv.byName.begin(), pv.byName.end(), null);
+        });
+        Timing prtV = timeIt(reps, [&] {
+            printStudentsByIndex(store, vv.byName.begin(), vv.byName.end(), null);
+        });
+        report("print", prtP, prtV);
+
+        std::cout << "  memory: " << studentsMemoryBytes(students) << " bytes (IStudentPtr) vs "
+                  << store.memoryBytes() << " bytes (variant)\n";
+        std::cout << "  identical output: "
+                  << (sameOutput(students, pv, store, vv) && sameQueries(pi, vi, students, store)
+                          ? "yes" : "NO")
+                  << "\n";
+    }
+    return 0;
+}
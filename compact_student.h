@@ -0,0 +1,208 @@
+#ifndef COMPACT_STUDENT_H
+#define COMPACT_STUDENT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "student.h"
+#include "string_interner.h"
+
+/*
+Template class: CompactStudent<RollT, CourseCodeT>
+
+Memory-lean twin of Student<RollT, CourseCodeT>, used when the ERP runs in
+compact mode. It has the same constructor and mutators, so the CSV loader can
+build either kind, and it implements the same IStudent interface, so the rest
+of the system does not care which one it gets.
+
+Layout differences:
+  - course codes and the branch are interned 16-bit IDs (see string_interner.h)
+  - grades are packed as 4-bit values, four per 16-bit word
+  - current courses, past courses and packed grades share ONE heap buffer:
+      [ current IDs | past IDs | packed grades ]
+    sized once by reserveCourses() (the CSV loader knows the counts up front)
+  - startingYear is 16 bits
+
+Limits (Student has none of them):
+  - more than 255 current or 255 past courses, or a starting year above 65535,
+    throws, so the CSV loader skips the row like any other malformed row
+  - past grades outside 0..15 are dropped
+*/
+template<typename RollT, typename CourseCodeT>
+class CompactStudent : public IStudent {
+public:
+    using roll_type        = RollT;
+    using course_code_type = CourseCodeT;
+
+private:
+    using id_type = StringInterner::id_type;
+
+    static constexpr int kGradesPerWord = 4;   // 4 bits each in a 16-bit word
+    static constexpr int kMaxPackedGrade = 15;
+
+    std::string name;
+    RollT roll;
+    std::unique_ptr<id_type[]> courses;   // layout described above
+    id_type branchId;
+    std::uint16_t startingYear;
+    std::uint8_t numCurrent = 0;          // entries in use
+    std::uint8_t numPast    = 0;
+    std::uint8_t capCurrent = 0;          // region sizes in the buffer
+    std::uint8_t capPast    = 0;
+
+    static std::size_t gradeWords(std::size_t past) {
+        return (past + kGradesPerWord - 1) / kGradesPerWord;
+    }
+
+    std::size_t bufferWords() const {
+        return capCurrent + capPast + gradeWords(capPast);
+    }
+
+    std::size_t pastBegin() const  { return capCurrent; }
+    std::size_t gradeBegin() const { return std::size_t(capCurrent) + capPast; }
+
+    int gradeAt(std::size_t i) const {
+        id_type word = courses[gradeBegin() + i / kGradesPerWord];
+        return (word >> (4 * (i % kGradesPerWord))) & 0xF;
+    }
+
+    // Re-allocate the buffer with room for exactly newCurrent / newPast
+    // entries, keeping the existing ones.
+    void relayout(std::size_t newCurrent, std::size_t newPast) {
+        if (newCurrent > std::numeric_limits<std::uint8_t>::max() ||
+            newPast    > std::numeric_limits<std::uint8_t>::max()) {
+            throw std::runtime_error("CompactStudent: too many courses");
+        }
+        const std::size_t words = newCurrent + newPast + gradeWords(newPast);
+        std::unique_ptr<id_type[]> next(new id_type[words]());
+
+        std::copy(courses.get(), courses.get() + numCurrent, next.get());
+        std::copy(courses.get() + pastBegin(),
+                  courses.get() + pastBegin() + numPast,
+                  next.get() + newCurrent);
+        std::copy(courses.get() + gradeBegin(),
+                  courses.get() + gradeBegin() + gradeWords(numPast),
+                  next.get() + newCurrent + newPast);
+
+        courses    = std::move(next);
+        capCurrent = static_cast<std::uint8_t>(newCurrent);
+        capPast    = static_cast<std::uint8_t>(newPast);
+    }
+
+public:
+    // Constructors
+
+    CompactStudent(const std::string& name,
+                   const RollT& roll,
+                   const std::string& branch,
+                   unsigned int startingYear)
+        : name(name),
+          roll(roll),
+          branchId(branchInterner().intern(branch)),
+          startingYear(static_cast<std::uint16_t>(startingYear))
+    {
+        if (startingYear > std::numeric_limits<std::uint16_t>::max()) {
+            throw std::runtime_error("CompactStudent: starting year out of range");
+        }
+    }
+
+    // Getters
+
+    const std::string& getName() const {
+        return name;
+    }
+
+    const RollT& getRoll() const {
+        return roll;
+    }
+
+    const std::string& getBranch() const {
+        return branchInterner().name(branchId);
+    }
+
+    // Mutators (same signatures as Student, so the CSV loader works for both)
+
+    // Size the buffer for the final course counts in one allocation.
+    // Adding beyond the reserved counts still works, one re-allocation per add.
+    void reserveCourses(std::size_t nCurrent, std::size_t nPast) {
+        if (nCurrent <= capCurrent && nPast <= capPast) return;
+        relayout(std::max<std::size_t>(nCurrent, capCurrent),
+                 std::max<std::size_t>(nPast, capPast));
+    }
+
+    void addCurrentCourse(const CourseCodeT& course) {
+        id_type id = courseCodeInterner().intern(toStringGeneric(course));
+        if (numCurrent == capCurrent) relayout(capCurrent + 1u, capPast);
+        courses[numCurrent++] = id;
+    }
+
+    // Grades that do not fit in 4 bits (< 0 or > 15) are dropped;
+    // the course index ignores anything outside 0..10 anyway.
+    void addPastCourse(const CourseCodeT& course, int grade) {
+        if (grade < 0 || grade > kMaxPackedGrade) return;
+        id_type id = courseCodeInterner().intern(toStringGeneric(course));
+        if (numPast == capPast) relayout(capCurrent, capPast + 1u);
+        const std::size_t i = numPast++;
+        courses[pastBegin() + i] = id;
+        courses[gradeBegin() + i / kGradesPerWord] |=
+            static_cast<id_type>(grade << (4 * (i % kGradesPerWord)));
+    }
+
+    // IStudent interface implementations:
+    std::string getNameStr() const override {
+        return name;
+    }
+
+    std::string getRollStr() const override {
+        return toStringGeneric(roll);
+    }
+
+    std::string getBranchStr() const override {
+        return getBranch();
+    }
+
+    unsigned int getStartingYear() const override {
+        return startingYear;
+    }
+
+    void forEachPastCourse(
+        const std::function<void(const std::string&, int)>& f
+    ) const override {
+        const StringInterner& codes = courseCodeInterner();
+        for (std::size_t i = 0; i < numPast; ++i) {
+            f(codes.name(courses[pastBegin() + i]), gradeAt(i));
+        }
+    }
+
+    bool hasGradeAtLeast(const std::string& course,
+                         int threshold) const override
+    {
+        if (threshold < 0) threshold = 0;
+        const StringInterner& codes = courseCodeInterner();
+        for (std::size_t i = 0; i < numPast; ++i) {
+            if (gradeAt(i) >= threshold &&
+                codes.name(courses[pastBegin() + i]) == course) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Interned tables are shared, so they are reported separately.
+    std::size_t memoryBytes() const override {
+        std::size_t bytes = sizeof(*this);
+        bytes += stringHeapBytes(name);
+        if constexpr (std::is_same_v<RollT, std::string>) {
+            bytes += stringHeapBytes(roll);
+        }
+        bytes += bufferWords() * sizeof(id_type);
+        return bytes;
+    }
+};
+
+#endif // COMPACT_STUDENT_H
@@ -5,12 +5,47 @@
 #include <array>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <atomic>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
 #include "erp_types.h"
+#include "memory_usage.h"
 
-// For a given course, keep buckets by grade (0..10), in case we wanted floating point grades.
+// Process-wide source of generation numbers: every value is used once, so a
+// generation never repeats, even across rebuilt or replaced indexes.
+inline std::uint64_t nextIndexGeneration() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+}
+
+// For a given course, keep students grouped by grade (0..10).
+// The 11 grade buckets are stored back to back in ONE vector (ascending grade),
+// so empty grades cost nothing and a ">= threshold" query is one contiguous range.
+// Entries are 32-bit positions in the owning CourseIndexDB's student table,
+// half the size of an IStudent* per entry.
 struct CourseIndex {
-    std::array<std::vector<IStudent*>, 11> grades; // grades[g] = students with grade == g
+    std::vector<std::uint32_t> students;        // grouped by grade, ascending
+    std::array<std::uint32_t, 12> gradeBegin{}; // grade g = [gradeBegin[g], gradeBegin[g+1])
+    std::uint64_t generation = 0;               // new non-zero value on every build
+
+    std::size_t memoryBytes() const {
+        return sizeof(*this) + vectorHeapBytes(students);
+    }
+};
+
+// One grade bucket of a course, read in place. Valid until the next build.
+class BucketView {
+public:
+    std::size_t size() const { return static_cast<std::size_t>(last_ - first_); }
+    IStudent* operator[](std::size_t i) const { return table_[first_[i]]; }
+
+private:
+    friend class CourseIndexDB;
+    const std::uint32_t* first_ = nullptr;
+    const std::uint32_t* last_  = nullptr;
+    IStudent* const* table_     = nullptr;
 };
 
 // Holds indices for all courses
@@ -19,18 +54,81 @@ public:
     // Build index from students list (a pre-process).
     // Uses the IStudent abstraction to iterate over past courses.
     void build(const std::vector<IStudentPtr>& students) {
+        buildFrom([&](const auto& f) {
+            for (const auto& uptr : students) {
+                if (!uptr) continue;
+                IStudent* s = uptr.get();
+                s->forEachPastCourse([&](const std::string& course, int grade) {
+                    f(s, course, grade);
+                });
+            }
+        });
+    }
+
+    // Generic build: forEachEntry(f) must call f(IStudent*, course, grade) for
+    // every past course of every student, in insertion order, and must give the
+    // same sequence each time it is called (it is called twice). A student's
+    // entries should be consecutive, so the student table holds it once.
+    // Lets stores that know the concrete student types skip virtual dispatch.
+    template<typename ForEachEntry>
+    void buildFrom(const ForEachEntry& forEachEntry) {
         index_.clear();
-        index_.reserve(students.size() * 2); // heuristic
-
-        for (const auto& uptr : students) {
-            if (!uptr) continue;
-            IStudent* s = uptr.get();
-            s->forEachPastCourse([&](const std::string& course, int grade) {
-                if (grade < 0 || grade > 10) return;
-                CourseIndex& ci = index_[course]; // O(1) access
-                ci.grades[grade].push_back(s); // O(1) insertion
-            });
+        students_.clear();
+
+        // Position of the current student in students_; both passes see the
+        // same sequence, so they assign the same positions.
+        IStudent* last = nullptr;
+        std::size_t next = 0;
+        auto position = [&](IStudent* s) {
+            if (s != last) {
+                last = s;
+                ++next;
+            }
+            return next - 1;
+        };
+
+        // Pass 1: fill the student table, count students per (course, grade).
+        forEachEntry([&](IStudent* s, const std::string& course, int grade) {
+            if (position(s) == students_.size()) {
+                if (students_.size() > std::numeric_limits<std::uint32_t>::max()) {
+                    throw std::length_error("CourseIndexDB: too many students");
+                }
+                students_.push_back(s);
+            }
+            if (grade < 0 || grade > 10) return;
+            ++index_[course].gradeBegin[grade + 1]; // O(1) access
+        });
+        students_.shrink_to_fit();
+
+        // Prefix sums turn the counts into bucket offsets; size each vector exactly.
+        // gradeBegin[g + 1] is then used as the fill cursor for grade g.
+        for (auto& kv : index_) {
+            CourseIndex& ci = kv.second;
+            for (int g = 1; g <= 11; ++g) ci.gradeBegin[g] += ci.gradeBegin[g - 1];
+            ci.students.resize(ci.gradeBegin[11]);
+            for (int g = 11; g >= 1; --g) ci.gradeBegin[g] = ci.gradeBegin[g - 1];
+            ci.generation = nextIndexGeneration();
         }
+
+        // Pass 2: place each student in its grade bucket (insertion order kept).
+        last = nullptr;
+        next = 0;
+        forEachEntry([&](IStudent* s, const std::string& course, int grade) {
+            std::size_t pos = position(s);
+            if (grade < 0 || grade > 10) return;
+            CourseIndex& ci = index_.find(course)->second;
+            ci.students[ci.gradeBegin[grade + 1]++] = static_cast<std::uint32_t>(pos);
+        });
+    }
+
+    // Current generation of a course's entries. Every build gives each course
+    // it contains a new, never-seen value: the entries point at the students
+    // the index was built from, so a cached result must not outlive a rebuild
+    // even when the data read back is the same. A course with no entries is
+    // always 0, because results for it point at nothing in this index.
+    std::uint64_t generation(const std::string& course) const {
+        auto it = index_.find(course);
+        return it == index_.end() ? 0 : it->second.generation;
     }
 
     // Query: all students with grade >= threshold in given course.
@@ -46,16 +144,43 @@ public:
         t = std::min(t, 10);
 
         const CourseIndex& ci = it->second;
-        for (int g = t; g <= 10; ++g) {
-            const auto& bucket = ci.grades[g];
-            result.insert(result.end(), bucket.begin(), bucket.end());
+        result.reserve(ci.students.size() - ci.gradeBegin[t]);
+        for (auto i = ci.students.begin() + ci.gradeBegin[t]; i != ci.students.end(); ++i) {
+            result.push_back(students_[*i]);
         }
 
         return result;
     }
 
+    // Students with exactly this grade in given course (one bucket), read in
+    // place; empty if none. Used when merging several indexes grade by grade.
+    BucketView bucket(const std::string& course, int grade) const {
+        BucketView view;
+        if (grade < 0 || grade > 10) return view;
+        auto it = index_.find(course);
+        if (it == index_.end()) return view;
+
+        const CourseIndex& ci = it->second;
+        view.first_ = ci.students.data() + ci.gradeBegin[grade];
+        view.last_  = ci.students.data() + ci.gradeBegin[grade + 1];
+        view.table_ = students_.data();
+        return view;
+    }
+
+    // Memory accounting: student table + hash table buckets + one node per course.
+    std::size_t memoryBytes() const {
+        std::size_t bytes = sizeof(*this) + vectorHeapBytes(students_);
+        bytes += index_.bucket_count() * sizeof(void*);
+        for (const auto& kv : index_) {
+            bytes += sizeof(void*) + sizeof(kv.first) + stringHeapBytes(kv.first);
+            bytes += kv.second.memoryBytes();
+        }
+        return bytes;
+    }
+
 private:
     std::unordered_map<std::string, CourseIndex> index_;
+    std::vector<IStudent*> students_;   // every indexed student, in insertion order
 };
 
 #endif // COURSE_INDEX_H
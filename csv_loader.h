@@ -8,6 +8,7 @@
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
+#include <type_traits>
 
 #include "erp_types.h"
 
@@ -40,7 +41,13 @@ inline std::string trim(const std::string& s) {
 //   4: StartingYear
 //   5: CurrentCourses        (semicolon-separated)
 //   6: PastCoursesGrades     (semicolon-separated "course:grade")
-inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
+//
+// IIITType / IITType are the concrete classes to build: Student<...> in standard
+// mode, CompactStudent<...> in compact mode (both share the same mutators).
+// The finished student is handed BY VALUE to emit(...), so callers decide how
+// to store it (heap + IStudentPtr, or a concrete-typed container).
+template<typename IIITType, typename IITType, typename Emit>
+inline void parseStudentRecordInto(const std::vector<std::string>& cols, Emit&& emit) {
     if (cols.size() < 7) {
         throw std::runtime_error("parseStudentRecord: not enough columns");
     }
@@ -62,7 +69,7 @@ inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
 
     // IIIT branch: roll = unsigned int, course codes = std::string
     if (institute == "IIIT") {
-        auto stu = std::make_unique<IIITStudent>(name, rollStr, branch, startingYear);
+        IIITType stu(name, rollStr, branch, startingYear);
         // unsigned int rollNum = 0;
         // try {
         //     rollNum = static_cast<unsigned int>(std::stoul(rollStr));
@@ -72,20 +79,26 @@ inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
         // 
         // auto stu = std::make_unique<IIITStudent>(name, rollNum, branch, startingYear);
 
+        // Size the course storage once (malformed entries below are skipped,
+        // so these are upper bounds).
+        auto tokens = currentStr.empty() ? std::vector<std::string>{}
+                                         : splitString(currentStr, ';');
+        auto pairs  = pastStr.empty() ? std::vector<std::string>{}
+                                      : splitString(pastStr, ';');
+        stu.reserveCourses(tokens.size(), pairs.size());
+
         // CurrentCourses: semicolon-separated strings
         if (!currentStr.empty()) {
-            auto tokens = splitString(currentStr, ';');
             for (auto& t : tokens) {
                 std::string courseCode = trim(t);
                 if (!courseCode.empty()) {
-                    stu->addCurrentCourse(courseCode); // std::string
+                    stu.addCurrentCourse(courseCode); // std::string
                 }
             }
         }
 
         // PastCoursesGrades: "course:grade;course:grade;..."
         if (!pastStr.empty()) {
-            auto pairs = splitString(pastStr, ';');
             for (auto& token : pairs) {
                 std::string entry = trim(token);
                 if (entry.empty()) continue;
@@ -104,11 +117,12 @@ inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
                 } catch (...) {
                     continue; // skip bad grade
                 }
-                stu->addPastCourse(courseCode, grade);
+                stu.addPastCourse(courseCode, grade);
             }
         }
 
-        return stu;
+        emit(std::move(stu));
+        return;
     }
 
     // IIT branch: roll = std::string, course codes = int
@@ -120,16 +134,21 @@ inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
         } catch (...) {
             throw std::runtime_error("Invalid IIT roll number: " + rollStr);
         }
-        auto stu = std::make_unique<IITStudent>(name, rollNum, branch, startingYear);
+        IITType stu(name, rollNum, branch, startingYear);
+        auto tokens = currentStr.empty() ? std::vector<std::string>{}
+                                         : splitString(currentStr, ';');
+        auto pairs  = pastStr.empty() ? std::vector<std::string>{}
+                                      : splitString(pastStr, ';');
+        stu.reserveCourses(tokens.size(), pairs.size());
+
         // CurrentCourses: semicolon-separated ints
         if (!currentStr.empty()) {
-            auto tokens = splitString(currentStr, ';');
             for (auto& t : tokens) {
                 std::string courseStr = trim(t);
                 if (courseStr.empty()) continue;
                 try {
                     int courseCode = std::stoi(courseStr);
-                    stu->addCurrentCourse(courseCode);
+                    stu.addCurrentCourse(courseCode);
                 } catch (...) {
                     // skip malformed course codes
                 }
@@ -138,7 +157,6 @@ inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
 
         // PastCoursesGrades: "course:grade;course:grade;..."
         if (!pastStr.empty()) {
-            auto pairs = splitString(pastStr, ';');
             for (auto& token : pairs) {
                 std::string entry = trim(token);
                 if (entry.empty()) continue;
@@ -160,22 +178,40 @@ inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols) {
                     continue; // skip malformed pair
                 }
 
-                stu->addPastCourse(courseCode, grade);
+                stu.addPastCourse(courseCode, grade);
             }
         }
 
-        return stu;
+        emit(std::move(stu));
+        return;
     }
 
     // If institute is unknown, you can either throw or skip.
     throw std::runtime_error("Unknown institute: " + institute);
 }
 
-// Load students from a CSV file into a single container of polymorphic pointers.
-// Preserves the insertion order from the file.
-inline std::vector<IStudentPtr> loadStudentsFromCSV(const std::string& filename) {
-    std::vector<IStudentPtr> students;
+template<typename IIITType, typename IITType>
+inline IStudentPtr parseStudentRecordAs(const std::vector<std::string>& cols) {
+    IStudentPtr ptr;
+    parseStudentRecordInto<IIITType, IITType>(cols, [&](auto&& stu) {
+        using T = std::decay_t<decltype(stu)>;
+        ptr = std::make_unique<T>(std::move(stu));
+    });
+    return ptr;
+}
+
+inline IStudentPtr parseStudentRecord(const std::vector<std::string>& cols,
+                                      StorageMode mode = StorageMode::Standard) {
+    if (mode == StorageMode::Compact) {
+        return parseStudentRecordAs<CompactIIITStudent, CompactIITStudent>(cols);
+    }
+    return parseStudentRecordAs<IIITStudent, IITStudent>(cols);
+}
 
+// Read a CSV file and call onRecord(cols) for every data line (header skipped).
+// Records that fail to parse (onRecord throws) are skipped.
+template<typename OnRecord>
+inline void forEachCSVRecord(const std::string& filename, OnRecord&& onRecord) {
     std::ifstream fin(filename);
     if (!fin.is_open()) {
         throw std::runtime_error("Could not open CSV file: " + filename);
@@ -185,7 +221,7 @@ inline std::vector<IStudentPtr> loadStudentsFromCSV(const std::string& filename)
 
     // Skip header line
     if (!std::getline(fin, line)) {
-        return students; // empty file
+        return; // empty file
     }
 
     // Read records
@@ -195,14 +231,27 @@ inline std::vector<IStudentPtr> loadStudentsFromCSV(const std::string& filename)
         auto cols = splitString(line, ',');
 
         try {
-            IStudentPtr ptr = parseStudentRecord(cols);
-            students.push_back(std::move(ptr));
+            onRecord(cols);
         } catch (const std::exception& e) {
             // Try and catch exceptons anywhere and everywhere xD
             continue;
         }
     }
+}
+
+// Load students from a CSV file into a single container of polymorphic pointers.
+// Preserves the insertion order from the file.
+inline std::vector<IStudentPtr> loadStudentsFromCSV(const std::string& filename,
+                                                    StorageMode mode = StorageMode::Standard) {
+    std::vector<IStudentPtr> students;
 
+    forEachCSVRecord(filename, [&](const std::vector<std::string>& cols) {
+        students.push_back(parseStudentRecord(cols, mode));
+    });
+
+    if (mode == StorageMode::Compact) {
+        students.shrink_to_fit(); // drop the vector's growth slack
+    }
     return students;
 }
 
@@ -2,7 +2,9 @@
 #define ERP_TYPES_H
 
 #include <memory>
+#include <vector>
 #include "student.h"
+#include "compact_student.h"
 
 // IIIT-Delhi:
 //   - RollNumber: string  (MT25003, PhD25033, ...)
@@ -14,7 +16,26 @@ using IIITStudent = Student<std::string, std::string>;
 //   - CourseCode: int           (615, 601, 701, 802, ...)
 using IITStudent = Student<unsigned int, int>;
 
+// Compact-mode counterparts: same field types, packed storage (compact_student.h)
+using CompactIIITStudent = CompactStudent<std::string, std::string>;
+using CompactIITStudent  = CompactStudent<unsigned int, int>;
+
 // Convenience alias for the polymorphic handle
 using IStudentPtr = std::unique_ptr<IStudent>;
 
+// Which concrete student classes (and view/index layout) to build.
+enum class StorageMode {
+    Standard, // Student<RollT, CourseCodeT>
+    Compact   // CompactStudent<RollT, CourseCodeT>, interned IDs, 4-bit grades
+};
+
+// Memory accounting: students + the vector that owns them.
+inline std::size_t studentsMemoryBytes(const std::vector<IStudentPtr>& students) {
+    std::size_t bytes = sizeof(students) + vectorHeapBytes(students);
+    for (const auto& s : students) {
+        if (s) bytes += s->memoryBytes();
+    }
+    return bytes;
+}
+
 #endif // ERP_TYPES_H
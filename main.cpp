@@ -2,47 +2,240 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <list>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 
 #include "csv_loader.h"
 #include "print_utils.h"
 #include "sorting.h"
 #include "course_index.h"
+#include "sharded_dataset.h"
+#include "async_query.h"
 
 // Helper to safely get a line from std::cin after numeric input
 inline void clearInputLine() {
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
-int main() {
-    std::string filename;
-    std::cout << "Enter CSV filename (e.g. students_sample.csv): ";
-    std::getline(std::cin, filename);
+// Warn about roll numbers that occur in more than one loaded shard
+inline void reportDuplicateRolls(const ShardedDataset& dataset) {
+    const std::size_t maxShown = 10;
+    auto dups = dataset.findDuplicateRolls();
+    for (std::size_t i = 0; i < dups.size() && i < maxShown; ++i) {
+        const auto& d = dups[i];
+        std::cout << "[WARN] Duplicate roll " << d.roll << " in:";
+        for (std::size_t s : d.shards) {
+            std::cout << ' ' << dataset.shard(s).source;
+        }
+        std::cout << '\n';
+    }
+    if (dups.size() > maxShown) {
+        std::cout << "[WARN] ... " << (dups.size() - maxShown)
+                  << " more duplicate rolls across shards\n";
+    }
+}
+
+// Set by Ctrl+C while a query is streaming: cancels it instead of killing the ERP.
+static std::atomic<bool> gInterrupted{false};
+
+extern "C" void onInterrupt(int) {
+    gInterrupted = true;
+}
+
+// A collected result is either a container of IStudent* or a shared QueryResult.
+template<typename Container>
+inline const Container& studentRange(const Container& c) { return c; }
+
+inline const std::vector<IStudent*>& studentRange(const QueryResult& r) { return *r; }
+
+// One streamed chunk of formatted output.
+struct StudentBatch {
+    std::string text;
+    std::size_t count = 0; // students in text
+};
+
+// How a streamed print ended.
+struct StreamOutcome {
+    TaskStatus status;
+    std::size_t printed; // students printed before it ended
+};
+
+// Run collect(stop) on the pool and stream the students it returns to std::cout.
+// collect polls stop while gathering results and gives up (QueryCancelled) once
+// the task is cancelled or past its deadline. Formatting happens on the worker,
+// 256 students per batch; this thread only prints batches, reports progress
+// every second and reacts to Ctrl+C.
+template<typename Collect>
+StreamOutcome streamStudents(ThreadPool& pool, Collect collect, const TaskOptions& opts) {
+    const std::size_t batchSize = 256;
+
+    auto task = runStreaming<StudentBatch>(pool, [collect](TaskContext<StudentBatch>& ctx) {
+        StopPredicate stop = [&ctx]() { return ctx.shouldStop(); };
+        decltype(collect(stop)) collected;
+        try {
+            collected = collect(stop);
+        } catch (const QueryCancelled&) {
+            return; // ctx.stopped() is set: reported as cancelled / deadline
+        }
+        const auto& students = studentRange(collected);
+        ctx.setTotal(students.size());
+
+        std::ostringstream batch;
+        std::size_t inBatch = 0;
+        for (IStudent* s : students) {
+            if (inBatch == 0 && ctx.shouldStop()) return;
+            if (s) printStudent(*s, batch);
+            if (++inBatch == batchSize) {
+                if (!ctx.emit(StudentBatch{batch.str(), inBatch})) return;
+                ctx.advance(inBatch);
+                batch.str("");
+                inBatch = 0;
+            }
+        }
+        if (inBatch > 0 && ctx.emit(StudentBatch{batch.str(), inBatch})) ctx.advance(inBatch);
+    }, opts);
+
+    gInterrupted = false;
+    auto previous = std::signal(SIGINT, onInterrupt);
+
+    using Clock = std::chrono::steady_clock;
+    auto lastProgress = Clock::now();
+    std::size_t printed = 0;
+    bool abandoned = false; // stopped printing on Ctrl+C / deadline
+    StudentBatch batch;
+    while (!task->finished()) {
+        if (gInterrupted) task->cancel();
+        if (gInterrupted || task->deadlinePassed()) {
+            // Show nothing more, not even batches already formatted and queued.
+            abandoned = true;
+            break;
+        }
+        if (task->next(batch, std::chrono::milliseconds(100))) {
+            std::cout << batch.text;
+            printed += batch.count;
+        }
+        if (Clock::now() - lastProgress >= std::chrono::seconds(1) && !task->finished()) {
+            if (task->total() == 0) {
+                std::cerr << "[PROGRESS] collecting results (Ctrl+C to cancel)\n";
+            } else {
+                std::cerr << "[PROGRESS] " << task->done() << "/" << task->total()
+                          << " students (Ctrl+C to cancel)\n";
+            }
+            lastProgress = Clock::now();
+        }
+    }
+    TaskStatus status = task->wait(); // discards the batches still queued
+    std::signal(SIGINT, previous);
+
+    // The producer may have finished just before we stopped reading; what the
+    // user saw was still cut short.
+    if (abandoned && status == TaskStatus::Completed && printed < task->total()) {
+        status = gInterrupted ? TaskStatus::Cancelled : TaskStatus::DeadlineExceeded;
+    }
+
+    if (status == TaskStatus::Cancelled) {
+        std::cout << "[CANCELLED] after " << printed << "/" << task->total() << " students\n";
+    } else if (status == TaskStatus::DeadlineExceeded) {
+        std::cout << "[DEADLINE] exceeded after " << printed << "/" << task->total() << " students\n";
+    } else if (status == TaskStatus::Failed) {
+        try {
+            task->rethrowIfFailed();
+        } catch (const std::exception& e) {
+            std::cerr << "Query failed: " << e.what() << "\n";
+        }
+    }
+    return StreamOutcome{status, printed};
+}
 
-    if (filename.empty()) {
+// Usage: ./erp [--compact] [--cache-size N] [--deadline-ms N]
+//   --compact      : use CompactStudent storage (interned course IDs, 4-bit grades;
+//                    past grades outside 0..15 are dropped; rows with more than
+//                    255 current / past courses or a year above 65535 are skipped)
+//   --cache-size N : keep up to N cached query results (default 64, 0 disables)
+//   --deadline-ms N: abort a query / print that runs longer than N ms (default: none)
+int main(int argc, char* argv[]) {
+    StorageMode mode = StorageMode::Standard;
+    std::size_t cacheSize = 64;
+    TaskOptions taskOptions;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compact") {
+            mode = StorageMode::Compact;
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            try {
+                cacheSize = std::stoul(argv[++i]);
+            } catch (...) {
+                std::cerr << "Invalid cache size: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--deadline-ms" && i + 1 < argc) {
+            try {
+                taskOptions.deadline = std::chrono::milliseconds(std::stoul(argv[++i]));
+            } catch (...) {
+                std::cerr << "Invalid deadline: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+    }
+
+    std::string spec;
+    std::cout << "Enter CSV filename(s) (e.g. students_sample.csv, "
+                 "a,b.csv, shards/*.csv or @manifest.txt): ";
+    std::getline(std::cin, spec);
+
+    std::vector<std::string> sources;
+    try {
+        sources = expandShardSources(spec);
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading sources: " << e.what() << "\n";
+        return 1;
+    }
+    if (sources.empty()) {
         std::cout << "No filename given.\n";
         return 0;
     }
 
-    // 1. Load students from CSV
-    std::vector<IStudentPtr> students;
+    // 1-3. Load every CSV as its own shard; each shard builds its sorted views
+    //      (parallel sorting) and course index, shards in parallel.
+    ShardedDataset dataset(cacheSize);
     try {
-        students = loadStudentsFromCSV(filename);
+        dataset.load(sources, mode);
     } catch (const std::exception& e) {
         std::cerr << "Error loading CSV: " << e.what() << "\n";
         return 1;
     }
 
-    if (students.empty()) {
+    if (dataset.studentCount() == 0) {
         std::cout << "No students loaded.\n";
         return 0;
     }
+    reportDuplicateRolls(dataset);
 
-    // 2. Build sorted views (parallel sorting)
-    SortViews views = buildAndSortViews(students);
+    // Queries and prints run here, streamed back to the menu loop.
+    ThreadPool pool(2);
 
-    // 3. Build course index
-    CourseIndexDB courseIndex;
-    courseIndex.build(students);
+    // Print a titled view, streamed from the pool.
+    auto showView = [&](const std::string& title, auto collect) {
+        std::cout << studentsHeader(title) << '\n';
+        streamStudents(pool, collect, taskOptions);
+        std::cout << studentsFooter(title) << '\n';
+    };
+
+    // Print a course query result, streamed from the pool.
+    auto showQuery = [&](const std::string& course, int threshold) {
+        std::cout << "Students with grade >= " << threshold
+                  << " in course '" << course << "':\n";
+        StreamOutcome outcome = streamStudents(pool,
+            [&dataset, course, threshold](const StopPredicate& stop) {
+                return dataset.cachedQueryAtLeast(course, threshold, stop);
+            }, taskOptions);
+        if (outcome.status == TaskStatus::Completed && outcome.printed == 0) {
+            std::cout << "(none)\n";
+        }
+    };
 
     // 4. Interactive menu
     while (true) {
@@ -53,6 +246,9 @@ int main() {
                   << "4. Show students sorted by name (list iterator view)\n"
                   << "5. Query: students with grade >= 9 in a course\n"
                   << "6. Query: students with grade >= custom threshold in a course\n"
+                  << "7. Show memory usage\n"
+                  << "8. Reload a shard\n"
+                  << "9. Show query cache statistics\n"
                   << "0. Exit\n"
                   << "Enter choice: ";
 
@@ -72,26 +268,29 @@ int main() {
 
         switch (choice) {
         case 1: {
-            printStudentsInsertionOrder(students);
+            showView("insertion order", [&dataset](const StopPredicate&) {
+                return dataset.insertionOrder();
+            });
             break;
         }
         case 2: {
-            printStudentsByIndex(students,
-                                 views.byName.begin(),
-                                 views.byName.end());
+            showView("sorted by name", [&dataset](const StopPredicate& stop) {
+                return dataset.mergedByName(stop);
+            });
             break;
         }
         case 3: {
-            printStudentsByIndex(students,
-                                 views.byRoll.begin(),
-                                 views.byRoll.end());
+            showView("sorted by roll", [&dataset](const StopPredicate& stop) {
+                return dataset.mergedByRoll(stop);
+            });
             break;
         }
         case 4: {
             // Demonstrate using a different iterator type (list)
-            printStudentsByIndex(students,
-                                 views.byNameList.begin(),
-                                 views.byNameList.end());
+            showView("sorted by name, list view", [&dataset](const StopPredicate& stop) {
+                auto byName = dataset.mergedByName(stop);
+                return std::list<IStudent*>(byName.begin(), byName.end());
+            });
             break;
         }
         case 5: {
@@ -100,18 +299,7 @@ int main() {
             std::getline(std::cin, course);
             course = trim(course); // trim is from csv_loader.h
 
-            int threshold = 9;
-            auto result = courseIndex.queryAtLeast(course, threshold);
-
-            std::cout << "Students with grade >= " << threshold
-                      << " in course '" << course << "':\n";
-            if (result.empty()) {
-                std::cout << "(none)\n";
-            } else {
-                for (IStudent* s : result) {
-                    printStudent(*s);
-                }
-            }
+            showQuery(course, 9);
             break;
         }
         case 6: {
@@ -130,16 +318,48 @@ int main() {
             }
             clearInputLine();
 
-            auto result = courseIndex.queryAtLeast(course, threshold);
-            std::cout << "Students with grade >= " << threshold
-                      << " in course '" << course << "':\n";
-            if (result.empty()) {
-                std::cout << "(none)\n";
-            } else {
-                for (IStudent* s : result) {
-                    printStudent(*s);
-                }
+            showQuery(course, threshold);
+            break;
+        }
+        case 7: {
+            MemoryReport report = dataset.memoryReport();
+            if (mode == StorageMode::Compact) {
+                report.sharedTables = courseCodeInterner().memoryBytes()
+                                    + branchInterner().memoryBytes();
+            }
+            printMemoryReport(report);
+            break;
+        }
+        case 8: {
+            for (std::size_t i = 0; i < dataset.shardCount(); ++i) {
+                std::cout << i << ". " << dataset.shard(i).source
+                          << " (" << dataset.shard(i).students.size() << " students)\n";
             }
+            std::cout << "Enter shard number: ";
+            std::size_t idx = 0;
+            if (!(std::cin >> idx) || idx >= dataset.shardCount()) {
+                std::cin.clear();
+                clearInputLine();
+                std::cout << "Invalid shard.\n";
+                break;
+            }
+            clearInputLine();
+
+            try {
+                dataset.reloadShard(idx);
+            } catch (const std::exception& e) {
+                std::cerr << "Error reloading shard: " << e.what() << "\n";
+                break;
+            }
+            std::cout << "Reloaded " << dataset.shard(idx).source << ".\n";
+            reportDuplicateRolls(dataset);
+            break;
+        }
+        case 9: {
+            QueryCacheStats st = dataset.cacheStats();
+            std::cout << "Query cache: " << st.size << "/" << st.capacity << " entries, "
+                      << st.hits << " hits, " << st.misses << " misses ("
+                      << st.stale << " stale), " << st.evictions << " evictions\n";
             break;
         }
         default:
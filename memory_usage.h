@@ -0,0 +1,52 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <list>
+
+/*
+Memory accounting helpers.
+
+Every structure reports the bytes it owns: its own object size plus the heap
+buffers it points to. Allocator bookkeeping (malloc headers, alignment) is not
+visible from C++ and is therefore not counted, so real resident memory is a bit
+higher than these numbers.
+*/
+
+// Heap bytes owned by a std::string (0 while the small-string buffer is used).
+inline std::size_t stringHeapBytes(const std::string& s) {
+    const char* obj  = reinterpret_cast<const char*>(&s);
+    const char* data = s.data();
+    if (data >= obj && data < obj + sizeof(std::string)) {
+        return 0; // short string, stored inside the object
+    }
+    return s.capacity() + 1;
+}
+
+// Heap bytes owned by a vector buffer (elements' own heap data not included).
+template<typename T>
+inline std::size_t vectorHeapBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+// Heap bytes owned by a list: one node (two links + value) per element.
+template<typename T>
+inline std::size_t listHeapBytes(const std::list<T>& l) {
+    return l.size() * (sizeof(T) + 2 * sizeof(void*));
+}
+
+// Summary printed by the "memory usage" menu option.
+struct MemoryReport {
+    std::size_t students     = 0; // student objects + the owning vector
+    std::size_t views        = 0; // SortViews index containers
+    std::size_t courseIndex  = 0; // CourseIndexDB
+    std::size_t sharedTables = 0; // interned course/branch tables (compact mode)
+
+    std::size_t total() const {
+        return students + views + courseIndex + sharedTables;
+    }
+};
+
+#endif // MEMORY_USAGE_H
@@ -4,7 +4,9 @@
 #include <iostream>
 #include <vector>
 #include <cstddef>
+#include <string>
 #include "erp_types.h"
+#include "memory_usage.h"
 
 // Basic printer for a single student
 inline void printStudent(const IStudent& s, std::ostream& os = std::cout) {
@@ -15,6 +17,17 @@ inline void printStudent(const IStudent& s, std::ostream& os = std::cout) {
        << '\n';
 }
 
+// Same output for a concrete Student: direct, non-virtual getters, no string copies
+// (used by the variant-based StudentStore, see variant_store.h)
+template<typename RollT, typename CourseCodeT>
+inline void printStudent(const Student<RollT, CourseCodeT>& s, std::ostream& os = std::cout) {
+    os << "Name: "          << s.getName()
+       << ", Roll: "        << s.getRoll()
+       << ", Branch: "      << s.getBranch()
+       << ", StartingYear: " << s.getStartingYearConcrete()
+       << '\n';
+}
+
 // Print list in insertion order (directly over students vector)
 inline void printStudentsInsertionOrder(
     const std::vector<IStudentPtr>& students,
@@ -45,4 +58,27 @@ inline void printStudentsByIndex(
     os << "================================\n";
 }
 
+// Header / footer lines framing a titled list of students
+inline std::string studentsHeader(const std::string& title) {
+    return "=== Students (" + title + ") ===";
+}
+
+inline std::string studentsFooter(const std::string& title) {
+    return std::string(studentsHeader(title).size(), '=');
+}
+
+// Print a memory accounting summary (bytes owned by each structure)
+inline void printMemoryReport(const MemoryReport& r, std::ostream& os = std::cout) {
+    auto line = [&](const char* label, std::size_t bytes) {
+        os << label << bytes << " bytes (" << (bytes / 1024) << " KiB)\n";
+    };
+    os << "=== Memory usage ===\n";
+    line("Students:      ", r.students);
+    line("Sorted views:  ", r.views);
+    line("Course index:  ", r.courseIndex);
+    line("Shared tables: ", r.sharedTables);
+    line("Total:         ", r.total());
+    os << "====================\n";
+}
+
 #endif // PRINT_UTILS_H
@@ -0,0 +1,134 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "student.h"
+
+// Immutable, shareable result of a course query.
+using QueryResult = std::shared_ptr<const std::vector<IStudent*>>;
+
+// Generation of a course in each shard, in shard order (see QueryCache).
+using GenerationStamp = std::vector<std::uint64_t>;
+
+// Hit/miss counters, used to size the cache.
+struct QueryCacheStats {
+    std::uint64_t hits      = 0;
+    std::uint64_t misses    = 0; // includes stale entries
+    std::uint64_t stale     = 0; // entry found, but its course had changed
+    std::uint64_t evictions = 0;
+    std::size_t   size      = 0;
+    std::size_t   capacity  = 0;
+};
+
+/*
+QueryCache: bounded LRU cache of (course, threshold) -> QueryResult.
+
+Each entry remembers the generation stamp of its course when it was computed:
+one CourseIndexDB::generation per shard. A lookup passes the current stamp; if
+they differ, a shard's entries for that course changed since (e.g. a reload of
+a shard containing it), so the entry is recomputed on demand. Reloading a
+shard that never contained the course leaves the stamp, and the entry, intact.
+
+All operations take one mutex, so any number of threads may query concurrently.
+The result vectors are immutable and shared, so a hit costs no copy.
+*/
+class QueryCache {
+public:
+    explicit QueryCache(std::size_t capacity = 64) : capacity_(capacity) {}
+
+    QueryResult getOrCompute(
+        const std::string& course,
+        int threshold,
+        const GenerationStamp& generation,
+        const std::function<std::vector<IStudent*>()>& compute
+    ) {
+        Key key{course, threshold};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = map_.find(key);
+            if (it != map_.end()) {
+                if (it->second->generation == generation) {
+                    ++stats_.hits;
+                    lru_.splice(lru_.begin(), lru_, it->second); // mark most recent
+                    return it->second->result;
+                }
+                ++stats_.stale;
+                lru_.erase(it->second);
+                map_.erase(it);
+            }
+            ++stats_.misses;
+        }
+
+        // Compute outside the lock so slow queries do not block cache hits.
+        // If compute throws (e.g. a cancelled query), nothing is cached.
+        QueryResult result = std::make_shared<const std::vector<IStudent*>>(compute());
+        if (capacity_ == 0) return result;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            // Another thread filled it meanwhile for the same data; keep it.
+            if (it->second->generation == generation) return result;
+            lru_.erase(it->second);
+            map_.erase(it);
+        }
+        lru_.push_front(Entry{key, generation, result});
+        map_.emplace(key, lru_.begin());
+        while (lru_.size() > capacity_) {
+            map_.erase(lru_.back().key);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+        return result;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lru_.clear();
+        map_.clear();
+    }
+
+    QueryCacheStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QueryCacheStats s = stats_;
+        s.size     = lru_.size();
+        s.capacity = capacity_;
+        return s;
+    }
+
+private:
+    struct Key {
+        std::string course;
+        int threshold;
+        bool operator==(const Key& o) const {
+            return threshold == o.threshold && course == o.course;
+        }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const {
+            return std::hash<std::string>()(k.course) * 31u
+                 + static_cast<std::size_t>(k.threshold);
+        }
+    };
+    struct Entry {
+        Key key;
+        GenerationStamp generation;
+        QueryResult result;
+    };
+
+    std::size_t capacity_;
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_; // front = most recently used
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> map_;
+    QueryCacheStats stats_;
+};
+
+#endif // QUERY_CACHE_H
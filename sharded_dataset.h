@@ -0,0 +1,408 @@
+#ifndef SHARDED_DATASET_H
+#define SHARDED_DATASET_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <glob.h>
+
+#include "erp_types.h"
+#include "csv_loader.h"
+#include "sorting.h"
+#include "course_index.h"
+#include "memory_usage.h"
+#include "query_cache.h"
+
+/*
+Sharded dataset: one shard per CSV file (e.g. one per institute/semester).
+
+Each shard owns its students, its SortViews and its CourseIndexDB, so:
+  - shards are loaded and indexed in parallel (one worker per shard, bounded
+    by the number of hardware threads);
+  - reloading one shard rebuilds only that shard;
+  - queries fan out to every shard and the per-shard sorted results are
+    k-way merged;
+  - repeated course queries are served from a QueryCache.
+*/
+
+struct Shard {
+    std::string source;                // CSV file this shard was loaded from
+    std::vector<IStudentPtr> students;
+    SortViews views;
+    CourseIndexDB index;
+};
+
+// Polled by long-running queries; returning true abandons the query, which
+// then throws QueryCancelled (nothing partial is returned or cached).
+using StopPredicate = std::function<bool()>;
+
+struct QueryCancelled : std::runtime_error {
+    QueryCancelled() : std::runtime_error("query cancelled") {}
+};
+
+// A roll number that appears in more than one shard.
+struct DuplicateRoll {
+    std::string roll;
+    std::vector<std::size_t> shards;   // distinct shards containing it, ascending
+};
+
+// Resolved form of a path, used to compare paths that name the same file
+// ("a.csv", "./a.csv", "dir/../a.csv"). Works for files that do not exist yet.
+inline std::string canonicalPathKey(const std::string& path) {
+    std::error_code ec;
+    auto p = std::filesystem::weakly_canonical(path, ec);
+    return ec ? std::filesystem::path(path).lexically_normal().string() : p.string();
+}
+
+// Expand a user-supplied source list into CSV filenames.
+// The list is comma-separated; each entry is one of:
+//   file.csv        a single file
+//   dir/*.csv       a glob pattern (must match at least one file)
+//   @manifest.txt   a manifest: one entry per line (blank lines and '#' comments skipped)
+// Relative entries inside a manifest are relative to the manifest's directory
+// (baseDir); top-level entries are relative to the working directory.
+// Throws on an unreadable manifest, a manifest that includes itself (directly
+// or through other manifests) and a glob pattern that matches nothing.
+// openManifests: manifests currently being expanded (the include chain).
+inline std::vector<std::string> expandShardSources(const std::string& spec,
+                                                   const std::filesystem::path& baseDir,
+                                                   std::vector<std::string>& openManifests) {
+    auto resolve = [&](const std::string& entry) {
+        std::filesystem::path p(entry);
+        return (baseDir.empty() || p.is_absolute()) ? entry : (baseDir / p).string();
+    };
+
+    std::vector<std::string> files;
+    for (const auto& raw : splitString(spec, ',')) {
+        std::string entry = trim(raw);
+        if (entry.empty()) continue;
+
+        if (entry[0] == '@') {
+            std::string path = resolve(entry.substr(1));
+            std::ifstream fin(path);
+            if (!fin.is_open()) {
+                throw std::runtime_error("Could not open manifest: " + path);
+            }
+            std::string key = canonicalPathKey(path);
+            if (std::find(openManifests.begin(), openManifests.end(), key)
+                    != openManifests.end()) {
+                throw std::runtime_error("Manifest includes itself: " + path);
+            }
+            openManifests.push_back(key);
+            const auto manifestDir = std::filesystem::path(path).parent_path();
+            std::string line;
+            while (std::getline(fin, line)) {
+                line = trim(line);
+                if (line.empty() || line[0] == '#') continue;
+                auto nested = expandShardSources(line, manifestDir, openManifests);
+                files.insert(files.end(), nested.begin(), nested.end());
+            }
+            openManifests.pop_back();
+        } else if (entry.find_first_of("*?[") != std::string::npos) {
+            std::string pattern = resolve(entry);
+            glob_t g{};
+            int rc = ::glob(pattern.c_str(), 0, nullptr, &g);
+            if (rc == 0) {
+                for (std::size_t i = 0; i < g.gl_pathc; ++i) {
+                    files.emplace_back(g.gl_pathv[i]); // glob() returns them sorted
+                }
+            }
+            globfree(&g);
+            if (rc == GLOB_NOMATCH) {
+                throw std::runtime_error("No files match: " + pattern);
+            } else if (rc != 0) {
+                throw std::runtime_error("Could not expand: " + pattern);
+            }
+        } else {
+            files.push_back(resolve(entry));
+        }
+    }
+    return files;
+}
+
+// Top-level expansion. A file named more than once (e.g. "a.csv,./a.csv", or a
+// glob plus an explicit name) is kept once, at its first position, so it is
+// not loaded as two shards.
+inline std::vector<std::string> expandShardSources(const std::string& spec) {
+    std::vector<std::string> openManifests;
+    std::vector<std::string> files;
+    std::unordered_set<std::string> seen;
+    for (auto& f : expandShardSources(spec, {}, openManifests)) {
+        if (seen.insert(canonicalPathKey(f)).second) files.push_back(std::move(f));
+    }
+    return files;
+}
+
+class ShardedDataset {
+public:
+    explicit ShardedDataset(std::size_t cacheCapacity = 64)
+        : cache_(cacheCapacity) {}
+
+    // Load every source as its own shard, in parallel.
+    // Throws the first loading error (e.g. a missing file) after all workers finish.
+    void load(const std::vector<std::string>& sources,
+              StorageMode mode = StorageMode::Standard)
+    {
+        mode_ = mode;
+        std::vector<Shard> shards(sources.size());
+        std::vector<std::exception_ptr> errors(sources.size());
+
+        std::atomic<std::size_t> next{0};
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < sources.size(); i = next++) {
+                try {
+                    buildShard(shards[i], sources[i]);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+
+        std::size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+        nThreads = std::min(nThreads, sources.size());
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < nThreads; ++t) threads.emplace_back(worker);
+        for (auto& t : threads) t.join();
+
+        for (const auto& e : errors) {
+            if (e) std::rethrow_exception(e);
+        }
+        shards_ = std::move(shards);
+    }
+
+    // Re-read one shard's CSV and rebuild only its views and index.
+    // Pointers previously returned for this shard become invalid.
+    void reloadShard(std::size_t i) {
+        if (i >= shards_.size()) {
+            throw std::out_of_range("reloadShard: no such shard");
+        }
+        Shard fresh;
+        buildShard(fresh, shards_[i].source);
+        shards_[i] = std::move(fresh);
+    }
+
+    std::size_t shardCount() const { return shards_.size(); }
+    const Shard& shard(std::size_t i) const { return shards_.at(i); }
+
+    std::size_t studentCount() const {
+        std::size_t n = 0;
+        for (const auto& sh : shards_) n += sh.students.size();
+        return n;
+    }
+
+    // All students, shard by shard, each shard in file order.
+    std::vector<IStudent*> insertionOrder() const {
+        std::vector<IStudent*> result;
+        result.reserve(studentCount());
+        for (const auto& sh : shards_) {
+            for (const auto& p : sh.students) {
+                if (p) result.push_back(p.get());
+            }
+        }
+        return result;
+    }
+
+    // Per-shard sorted views, k-way merged.
+    // stop is polled every kStopCheckInterval students (see StopPredicate).
+    std::vector<IStudent*> mergedByName(const StopPredicate& stop = {}) const {
+        return mergeViews(&SortViews::byName, &IStudent::getNameStr, stop);
+    }
+
+    std::vector<IStudent*> mergedByRoll(const StopPredicate& stop = {}) const {
+        return mergeViews(&SortViews::byRoll, &IStudent::getRollStr, stop);
+    }
+
+    // Fan out to every shard's index. Results are merged grade by grade
+    // (ascending, like CourseIndexDB::queryAtLeast), shards in load order.
+    // stop is polled every kStopCheckInterval students copied.
+    std::vector<IStudent*> queryAtLeast(const std::string& course,
+                                        int threshold,
+                                        const StopPredicate& stop = {}) const
+    {
+        int t = std::min(std::max(threshold, 0), 10);
+
+        std::size_t total = 0;
+        for (const auto& sh : shards_) {
+            for (int g = t; g <= 10; ++g) {
+                total += sh.index.bucket(course, g).size();
+            }
+        }
+
+        std::vector<IStudent*> result;
+        result.reserve(total);
+        for (int g = t; g <= 10; ++g) {
+            for (const auto& sh : shards_) {
+                BucketView b = sh.index.bucket(course, g);
+                for (std::size_t i = 0; i < b.size(); ++i) {
+                    result.push_back(b[i]);
+                    if ((i + 1) % kStopCheckInterval == 0 && stop && stop()) {
+                        throw QueryCancelled();
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Same as queryAtLeast, but served from the result cache unless a shard
+    // holding the course has been reloaded since the result was computed.
+    // A cancelled query
+    // (see StopPredicate) throws QueryCancelled and is not cached.
+    // Safe to call from several threads at once (but not during load/reload).
+    QueryResult cachedQueryAtLeast(const std::string& course, int threshold,
+                                   const StopPredicate& stop = {}) {
+        int t = std::min(std::max(threshold, 0), 10);
+        return cache_.getOrCompute(course, t, courseGeneration(course),
+                                   [&]() { return queryAtLeast(course, t, stop); });
+    }
+
+    // Generation of a course in every shard. It changes only when a shard
+    // that contains (or contained) the course is rebuilt, so reloading one
+    // shard keeps cached results for courses that shard never had.
+    GenerationStamp courseGeneration(const std::string& course) const {
+        GenerationStamp gen;
+        gen.reserve(shards_.size());
+        for (const auto& sh : shards_) gen.push_back(sh.index.generation(course));
+        return gen;
+    }
+
+    QueryCacheStats cacheStats() const { return cache_.stats(); }
+
+    // Roll numbers present in more than one shard (repeats inside a single
+    // file are left alone, as in the single-file loader). Uses the merged roll
+    // view: equal rolls come out adjacent, ordered by shard, so no extra
+    // lookup table is needed.
+    std::vector<DuplicateRoll> findDuplicateRolls() const {
+        std::vector<DuplicateRoll> dups;
+        DuplicateRoll run;
+
+        auto flush = [&]() {
+            if (run.shards.size() > 1) dups.push_back(run);
+            run.shards.clear();
+        };
+
+        forEachMerged(&SortViews::byRoll, &IStudent::getRollStr,
+                      [&](const std::string& roll, std::size_t shardIdx, IStudent*) {
+                          if (run.shards.empty() || run.roll != roll) {
+                              flush();
+                              run.roll = roll;
+                          }
+                          if (run.shards.empty() || run.shards.back() != shardIdx) {
+                              run.shards.push_back(shardIdx);
+                          }
+                      });
+        flush();
+        return dups;
+    }
+
+    // Memory accounting summed over all shards (shared tables not included).
+    MemoryReport memoryReport() const {
+        MemoryReport r;
+        r.students = sizeof(*this) + vectorHeapBytes(shards_);
+        for (const auto& sh : shards_) {
+            r.students    += stringHeapBytes(sh.source);
+            r.students    += studentsMemoryBytes(sh.students) - sizeof(sh.students);
+            r.views       += sh.views.memoryBytes() - sizeof(sh.views);
+            r.courseIndex += sh.index.memoryBytes() - sizeof(sh.index);
+        }
+        return r;
+    }
+
+private:
+    static constexpr std::size_t kStopCheckInterval = 4096;
+
+    using IndexVector = std::vector<ViewIndex> SortViews::*;
+    using KeyGetter   = std::string (IStudent::*)() const;
+
+    void buildShard(Shard& sh, const std::string& source) const {
+        sh.source   = source;
+        sh.students = loadStudentsFromCSV(source, mode_);
+        sh.views    = buildAndSortViews(sh.students, /*withNameList=*/false, source);
+        sh.index.build(sh.students);
+    }
+
+    // k-way merge of one sorted view across shards: a min-heap holds the
+    // current head (key, shard) of each shard's view.
+    // Throws QueryCancelled if stop returns true (polled every kStopCheckInterval).
+    void forEachMerged(
+        IndexVector view, KeyGetter key,
+        const std::function<void(const std::string&, std::size_t, IStudent*)>& f,
+        const StopPredicate& stop = {}
+    ) const {
+        struct Head {
+            std::string key;
+            std::size_t shard;
+            std::size_t pos;    // position within that shard's view
+        };
+        auto after = [](const Head& a, const Head& b) {
+            if (a.key != b.key) return a.key > b.key;
+            return a.shard > b.shard; // ties: lower shard first
+        };
+        std::priority_queue<Head, std::vector<Head>, decltype(after)> heap(after);
+
+        auto push = [&](std::size_t s, std::size_t pos) {
+            const auto& order = shards_[s].views.*view;
+            for (; pos < order.size(); ++pos) {
+                IStudent* stu = shards_[s].students[order[pos]].get();
+                if (stu) {
+                    heap.push(Head{(stu->*key)(), s, pos});
+                    return;
+                }
+            }
+        };
+
+        for (std::size_t s = 0; s < shards_.size(); ++s) push(s, 0);
+
+        std::size_t sinceCheck = 0;
+        while (!heap.empty()) {
+            if (++sinceCheck == kStopCheckInterval) {
+                if (stop && stop()) throw QueryCancelled();
+                sinceCheck = 0;
+            }
+            Head h = heap.top();
+            heap.pop();
+            const auto& order = shards_[h.shard].views.*view;
+            f(h.key, h.shard, shards_[h.shard].students[order[h.pos]].get());
+            push(h.shard, h.pos + 1);
+        }
+    }
+
+    std::vector<IStudent*> mergeViews(IndexVector view, KeyGetter key,
+                                      const StopPredicate& stop) const {
+        std::vector<IStudent*> result;
+        result.reserve(studentCount());
+        if (shards_.size() == 1) {
+            // Nothing to merge: map the shard's view straight to pointers.
+            const Shard& sh = shards_[0];
+            std::size_t sinceCheck = 0;
+            for (ViewIndex idx : sh.views.*view) {
+                if (++sinceCheck == kStopCheckInterval) {
+                    if (stop && stop()) throw QueryCancelled();
+                    sinceCheck = 0;
+                }
+                if (sh.students[idx]) result.push_back(sh.students[idx].get());
+            }
+            return result;
+        }
+        forEachMerged(view, key, [&](const std::string&, std::size_t, IStudent* s) {
+            result.push_back(s);
+        }, stop);
+        return result;
+    }
+
+    StorageMode mode_ = StorageMode::Standard;
+    std::vector<Shard> shards_;
+    QueryCache cache_;
+};
+
+#endif // SHARDED_DATASET_H
@@ -8,8 +8,12 @@
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 
 #include "erp_types.h"
+#include "memory_usage.h"
 
 // Simple time logger
 inline void logDuration(const std::string& label,
@@ -18,15 +22,34 @@ inline void logDuration(const std::string& label,
 {
     using namespace std::chrono;
     auto dur = duration_cast<milliseconds>(end - start).count();
-    std::cout << "[TIMER] " << label << " took " << dur << " ms\n";
+    // One write per line, so lines from concurrent sorts do not interleave.
+    std::cout << ("[TIMER] " + label + " took " + std::to_string(dur) + " ms\n");
+}
+
+// Position of a student in its container. 32 bits halve the views' memory;
+// buildAndSortViews rejects containers too large for it.
+using ViewIndex = std::uint32_t;
+
+inline void checkViewSize(std::size_t n) {
+    if (n > std::numeric_limits<ViewIndex>::max()) {
+        throw std::length_error("buildAndSortViews: too many students");
+    }
 }
 
 // Holds sorted views (indices), does not copy student objects
 struct SortViews {
     // These are the different iterators.
-    std::vector<std::size_t> byName;
-    std::vector<std::size_t> byRoll;
-    std::list<std::size_t> byNameList; // same as byName, but using list iterators
+    std::vector<ViewIndex> byName;
+    std::vector<ViewIndex> byRoll;
+    std::list<ViewIndex> byNameList;   // same as byName, but using list iterators
+                                       // (left empty when not requested)
+
+    std::size_t memoryBytes() const {
+        return sizeof(*this)
+             + vectorHeapBytes(byName)
+             + vectorHeapBytes(byRoll)
+             + listHeapBytes(byNameList);
+    }
 };
 
 // Build index vectors and sort them in parallel.
@@ -37,10 +60,17 @@ struct SortViews {
 // 2. THREAD SAFETY: The main `students` vector is treated as READ-ONLY during sorting. Each thread modifies its own private index vector.
 //    Since they don't write to the same memory location, there is no Race Condition.
 
-inline SortViews buildAndSortViews(const std::vector<IStudentPtr>& students) {
+// The list view only duplicates byName; callers that never read it (e.g. the
+// sharded dataset, which merges byName across shards) pass withNameList = false.
+// source, if given, is added to the [TIMER] lines (several shards sort at once).
+inline SortViews buildAndSortViews(const std::vector<IStudentPtr>& students,
+                                   bool withNameList = true,
+                                   const std::string& source = "") {
+    const std::string suffix = source.empty() ? "" : " (" + source + ")";
     SortViews views;
 
     const std::size_t n = students.size();
+    checkViewSize(n);
     views.byName.resize(n);
     views.byRoll.resize(n);
 
@@ -52,23 +82,23 @@ inline SortViews buildAndSortViews(const std::vector<IStudentPtr>& students) {
     auto sortByName = [&]() {
         auto start = std::chrono::high_resolution_clock::now();
         std::sort(views.byName.begin(), views.byName.end(),
-                  [&](std::size_t a, std::size_t b) {
+                  [&](ViewIndex a, ViewIndex b) {
                       if (!students[a] || !students[b]) return a < b;
                       return students[a]->getNameStr() < students[b]->getNameStr();
                   });
         auto end = std::chrono::high_resolution_clock::now();
-        logDuration("Sort by name", start, end);
+        logDuration("Sort by name" + suffix, start, end);
     };
 
     auto sortByRoll = [&]() {
         auto start = std::chrono::high_resolution_clock::now();
         std::sort(views.byRoll.begin(), views.byRoll.end(),
-                  [&](std::size_t a, std::size_t b) {
+                  [&](ViewIndex a, ViewIndex b) {
                       if (!students[a] || !students[b]) return a < b;
                       return students[a]->getRollStr() < students[b]->getRollStr();
                   });
         auto end = std::chrono::high_resolution_clock::now();
-        logDuration("Sort by roll", start, end);
+        logDuration("Sort by roll" + suffix, start, end);
     };
 
     // Two threads in parallel
@@ -78,7 +108,9 @@ inline SortViews buildAndSortViews(const std::vector<IStudentPtr>& students) {
     t2.join();
 
     // Build a list-based view from the name-sorted indices (different iterator type, Q4).
-    views.byNameList.assign(views.byName.begin(), views.byName.end());
+    if (withNameList) {
+        views.byNameList.assign(views.byName.begin(), views.byName.end());
+    }
 
     return views;
 }
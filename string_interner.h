@@ -0,0 +1,88 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "memory_usage.h"
+
+/*
+StringInterner: maps each distinct string to a small 16-bit ID.
+
+Used by the compact storage mode so that a student stores a 2-byte ID per
+course (or branch) instead of a full std::string / int.
+Strings live in a std::deque so references returned by name() stay valid while
+new strings are added. Guarded by a shared_mutex so several loader threads can
+intern at the same time.
+*/
+class StringInterner {
+public:
+    using id_type = std::uint16_t;
+
+    id_type intern(const std::string& s) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = ids_.find(s);
+            if (it != ids_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(s);
+        if (it != ids_.end()) return it->second;
+
+        if (names_.size() > std::numeric_limits<id_type>::max()) {
+            throw std::runtime_error("StringInterner: too many distinct strings");
+        }
+        id_type id = static_cast<id_type>(names_.size());
+        names_.push_back(s);
+        ids_.emplace(s, id);
+        return id;
+    }
+
+    const std::string& name(id_type id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return names_[id];
+    }
+
+    std::size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return names_.size();
+    }
+
+    std::size_t memoryBytes() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::size_t bytes = sizeof(*this);
+        for (const auto& s : names_) {
+            bytes += sizeof(std::string) + stringHeapBytes(s);
+        }
+        // map: bucket array + one node (key copy + id + link) per entry
+        bytes += ids_.bucket_count() * sizeof(void*);
+        for (const auto& kv : ids_) {
+            bytes += sizeof(kv) + sizeof(void*) + stringHeapBytes(kv.first);
+        }
+        return bytes;
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string, id_type> ids_;
+};
+
+// Process-wide tables shared by all compact students.
+inline StringInterner& courseCodeInterner() {
+    static StringInterner interner;
+    return interner;
+}
+
+inline StringInterner& branchInterner() {
+    static StringInterner interner;
+    return interner;
+}
+
+#endif // STRING_INTERNER_H
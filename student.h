@@ -7,6 +7,8 @@
 #include <sstream>
 #include <array>
 
+#include "memory_usage.h"
+
 /* 
 Data Abstraction and Hiding
 
@@ -37,6 +39,9 @@ public:
     // All "course" are compared in string form.
     virtual bool hasGradeAtLeast(const std::string& course,
                                  int threshold) const = 0;
+
+    // Memory accounting: bytes owned by this student (object + heap buffers).
+    virtual std::size_t memoryBytes() const = 0;
 };
 
 
@@ -133,6 +138,11 @@ public:
 
     // Mutators
 
+    void reserveCourses(std::size_t nCurrent, std::size_t nPast) {
+        currentCourses.reserve(nCurrent);
+        pastCourses.reserve(nPast);
+    }
+
     void addCurrentCourse(const CourseCodeT& course) {
         currentCourses.push_back(course);
     }
@@ -179,6 +189,23 @@ public:
         }
         return false;
     }
+
+    std::size_t memoryBytes() const override {
+        std::size_t bytes = sizeof(*this);
+        bytes += stringHeapBytes(name) + stringHeapBytes(branch);
+        bytes += heapBytesOf(roll);
+        bytes += vectorHeapBytes(currentCourses);
+        for (const auto& c : currentCourses) bytes += heapBytesOf(c);
+        bytes += vectorHeapBytes(pastCourses);
+        for (const auto& pc : pastCourses) bytes += heapBytesOf(pc.code);
+        return bytes;
+    }
+
+private:
+    // Heap owned by a roll / course code value (only strings own any).
+    static std::size_t heapBytesOf(const std::string& s) { return stringHeapBytes(s); }
+    template<typename T>
+    static std::size_t heapBytesOf(const T&) { return 0; }
 };
 
 #endif // STUDENT_H
@@ -0,0 +1,230 @@
+#ifndef VARIANT_STORE_H
+#define VARIANT_STORE_H
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "erp_types.h"
+#include "csv_loader.h"
+#include "sorting.h"
+#include "course_index.h"
+#include "memory_usage.h"
+#include "print_utils.h"
+
+/*
+Variant-based student store: an alternative to std::vector<IStudentPtr>.
+
+Only a few Student<RollT, CourseCodeT> instantiations exist (erp_types.h), so
+they can be held BY VALUE in a std::variant. Sorting, index building and
+printing then go through std::visit / if constexpr: every operation is
+generated once per concrete type, calls are direct (and inlinable), and keys
+are read through the concrete getters (const std::string&) instead of being
+copied out through the virtual getNameStr() / getRollStr().
+
+The IStudentPtr path stays the default, and is the one to extend with new
+student kinds. Elements are still IStudents, so a CourseIndexDB built from a
+store holds ordinary IStudent* pointers (valid while the store is not modified).
+See bench_variant.cpp for a comparison of the two paths.
+*/
+
+template<typename... StudentTs>
+class VariantStudentStore {
+public:
+    using value_type = std::variant<StudentTs...>;
+
+    template<typename S>
+    void push_back(S&& s) {
+        students_.emplace_back(std::forward<S>(s));
+    }
+
+    std::size_t size() const { return students_.size(); }
+    bool empty() const { return students_.empty(); }
+    const value_type& operator[](std::size_t i) const { return students_[i]; }
+
+    auto begin() const { return students_.begin(); }
+    auto end() const { return students_.end(); }
+
+    void shrink_to_fit() { students_.shrink_to_fit(); }
+
+    // f(IStudent*, courseCodeAsString, grade) for every past course, in insertion order.
+    template<typename F>
+    void forEachPastCourse(F&& f) const {
+        std::string codeBuf; // reused for non-string course codes
+        for (const auto& v : students_) {
+            std::visit([&](const auto& s) {
+                IStudent* base = const_cast<IStudent*>(static_cast<const IStudent*>(&s));
+                for (const auto& pc : s.getPastCourses()) {
+                    f(base, courseKey(pc.code, codeBuf), pc.grade);
+                }
+            }, v);
+        }
+    }
+
+    // Memory accounting: vector buffer + heap owned by each student.
+    std::size_t memoryBytes() const {
+        std::size_t bytes = sizeof(*this) + vectorHeapBytes(students_);
+        for (const auto& v : students_) {
+            std::visit([&](const auto& s) {
+                bytes += s.memoryBytes() - sizeof(s); // object itself is in the buffer
+            }, v);
+        }
+        return bytes;
+    }
+
+    // Course code as the string used by CourseIndexDB.
+    template<typename CodeT>
+    static const std::string& courseKey(const CodeT& code, std::string& buf) {
+        if constexpr (std::is_same_v<CodeT, std::string>) {
+            return code;
+        } else if constexpr (std::is_integral_v<CodeT>) {
+            char digits[24];
+            auto r = std::to_chars(digits, digits + sizeof(digits), code);
+            buf.assign(digits, r.ptr);
+            return buf;
+        } else {
+            buf = toStringGeneric(code);
+            return buf;
+        }
+    }
+
+private:
+    std::vector<value_type> students_;
+};
+
+// The concrete student kinds known to this ERP.
+using StudentStore = VariantStudentStore<IIITStudent, IITStudent>;
+
+// Load a CSV straight into a StudentStore (no per-student heap allocation).
+inline StudentStore loadStudentStoreFromCSV(const std::string& filename) {
+    StudentStore store;
+    forEachCSVRecord(filename, [&](const std::vector<std::string>& cols) {
+        parseStudentRecordInto<IIITStudent, IITStudent>(cols, [&](auto&& stu) {
+            store.push_back(std::move(stu));
+        });
+    });
+    store.shrink_to_fit(); // objects live in the buffer: drop growth slack
+    return store;
+}
+
+// Roll number as a string_view, without allocating for integral rolls.
+// Orders exactly like IStudent::getRollStr().
+struct RollKeyBuffer {
+    char digits[24];
+    std::string text; // fallback for other roll types
+};
+
+template<typename S>
+inline std::string_view rollKey(const S& s, RollKeyBuffer& buf) {
+    using RollT = typename S::roll_type;
+    if constexpr (std::is_same_v<RollT, std::string>) {
+        return s.getRoll();
+    } else if constexpr (std::is_integral_v<RollT>) {
+        auto r = std::to_chars(buf.digits, buf.digits + sizeof(buf.digits), s.getRoll());
+        return std::string_view(buf.digits, static_cast<std::size_t>(r.ptr - buf.digits));
+    } else {
+        buf.text = toStringGeneric(s.getRoll());
+        return buf.text;
+    }
+}
+
+// Same views as buildAndSortViews(std::vector<IStudentPtr>), same two threads,
+// but comparisons dispatch on the concrete types.
+template<typename... StudentTs>
+inline SortViews buildAndSortViews(const VariantStudentStore<StudentTs...>& students) {
+    SortViews views;
+
+    const std::size_t n = students.size();
+    checkViewSize(n);
+    views.byName.resize(n);
+    views.byRoll.resize(n);
+
+    std::iota(views.byName.begin(), views.byName.end(), 0);
+    std::iota(views.byRoll.begin(),  views.byRoll.end(),  0);
+
+    auto sortByName = [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto name = [](const auto& v) -> const std::string& {
+            return std::visit([](const auto& s) -> const std::string& {
+                return s.getName();
+            }, v);
+        };
+        std::sort(views.byName.begin(), views.byName.end(),
+                  [&](ViewIndex a, ViewIndex b) {
+                      return name(students[a]) < name(students[b]);
+                  });
+        auto end = std::chrono::high_resolution_clock::now();
+        logDuration("Sort by name", start, end);
+    };
+
+    auto sortByRoll = [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        RollKeyBuffer bufA, bufB;
+        auto roll = [](const auto& v, RollKeyBuffer& buf) {
+            return std::visit([&](const auto& s) { return rollKey(s, buf); }, v);
+        };
+        std::sort(views.byRoll.begin(), views.byRoll.end(),
+                  [&](ViewIndex a, ViewIndex b) {
+                      return roll(students[a], bufA) < roll(students[b], bufB);
+                  });
+        auto end = std::chrono::high_resolution_clock::now();
+        logDuration("Sort by roll", start, end);
+    };
+
+    std::thread t1(sortByName);
+    std::thread t2(sortByRoll);
+    t1.join();
+    t2.join();
+
+    views.byNameList.assign(views.byName.begin(), views.byName.end());
+
+    return views;
+}
+
+// Build a CourseIndexDB from a store, without virtual calls or std::function.
+template<typename... StudentTs>
+inline void buildCourseIndex(CourseIndexDB& index,
+                             const VariantStudentStore<StudentTs...>& students) {
+    index.buildFrom([&](const auto& f) { students.forEachPastCourse(f); });
+}
+
+// Printing: same output as the IStudentPtr versions in print_utils.h.
+template<typename... StudentTs>
+inline void printStudentsInsertionOrder(
+    const VariantStudentStore<StudentTs...>& students,
+    std::ostream& os = std::cout
+) {
+    os << "=== Students (insertion order) ===\n";
+    for (const auto& v : students) {
+        std::visit([&](const auto& s) { printStudent(s, os); }, v);
+    }
+    os << "==================================\n";
+}
+
+template<typename... StudentTs, typename IndexIter>
+inline void printStudentsByIndex(
+    const VariantStudentStore<StudentTs...>& students,
+    IndexIter begin,
+    IndexIter end,
+    std::ostream& os = std::cout
+) {
+    os << "=== Students (indexed view) ===\n";
+    for (auto it = begin; it != end; ++it) {
+        std::size_t idx = static_cast<std::size_t>(*it);
+        if (idx < students.size()) {
+            std::visit([&](const auto& s) { printStudent(s, os); }, students[idx]);
+        }
+    }
+    os << "================================\n";
+}
+
+#endif // VARIANT_STORE_H